@@ -3,18 +3,7 @@
 
 #include "Board.h"
 
-#define shiftR(var) (var | (var >> shift & fastMask))
-#define shiftL(var) (var | (var << shift & fastMask))
-
-const bool BLACK = 1;
-const bool WHITE = 0;
-const uint64_t ONE64 = 1;
-
-inline uint8_t countBitsSet(uint64_t in) {
-    return (uint8_t) __builtin_popcountll(in);
-}
-
-inline Position createBoard(char * position) {
+Position createBoard(char * position) {
     return readFromString(position);
 }
 
@@ -86,15 +75,6 @@ Position readFromString(char * posString) {
     return pos;
 }
 
-inline bool squareIsOccupied(Position * pos, uint8_t square) {
-    return (pos->occupied) >> square & 1;
-}
-
-// Assumes that a piece is on the square.
-inline bool getPieceAt(Position * pos, uint8_t square) {
-    return (pos->team[BLACK]) >> square & 1;
-}
-
 void print(Position * pos, bool extraInfo) {
     printf("\n");
     for(int y = 0; y < 8; ++y) {
@@ -136,200 +116,3 @@ void print(Position * pos, bool extraInfo) {
         printf("Last Move Passed: %d\n", pos->lastMoveSkipped);
     }
 }
-
-inline int8_t getWinner(Position * pos) {
-    uint8_t blackCount = countBitsSet(pos->team[BLACK]);
-    uint8_t whiteCount = countBitsSet(pos->team[WHITE]);
-    return blackCount > whiteCount ? -1 : (whiteCount > blackCount ? 1 : 0);
-}
-
-__attribute__((always_inline)) uint64_t getAllLegalMovesMask(Position * pos) {
-    // Used in masking
-    const uint64_t friendlyStones = pos->team[pos->turn];
-    const uint64_t enemyStones = pos->team[!pos->turn];
-    // Squares that don't have a stone on them.
-    const uint64_t emptySquares = ~pos->occupied;
-    uint64_t output = 0;
-    // A temporary holder for the moves in each direction
-    register uint64_t tempMoves asm("x9");
-    uint64_t fastMask;
-
-    // Each set is ~26 ASM instructions in x86
-    register int8_t shift asm("x10");
-    shift = 1;
-    register uint64_t MACROMASK asm("x11");
-    MACROMASK = 0x7F7F7F7F7F7F7F7F;
-    fastMask = MACROMASK & enemyStones;
-    tempMoves = (friendlyStones >> shift & fastMask);
-    tempMoves = shiftR(shiftR(shiftR(shiftR(shiftR(tempMoves)))));
-    output |= (tempMoves >> shift & MACROMASK) & emptySquares;
-
-    MACROMASK = 0xFEFEFEFEFEFEFEFE;
-    fastMask = MACROMASK & enemyStones;
-    tempMoves = (friendlyStones << shift & fastMask);
-    tempMoves = shiftL(shiftL(shiftL(shiftL(shiftL(tempMoves)))));
-    output |= (tempMoves << shift & MACROMASK) & emptySquares;
-
-    shift = 9;
-    MACROMASK = 0x007F7F7F7F7F7F7F;
-    fastMask = MACROMASK & enemyStones;
-    tempMoves = (friendlyStones >> shift & fastMask);
-    tempMoves = shiftR(shiftR(shiftR(shiftR(shiftR(tempMoves)))));
-    output |= (tempMoves >> shift & MACROMASK) & emptySquares;
-
-    MACROMASK = 0xFEFEFEFEFEFEFE00;
-    fastMask = MACROMASK & enemyStones;
-    tempMoves = (friendlyStones << shift & fastMask);
-    tempMoves = shiftL(shiftL(shiftL(shiftL(shiftL(tempMoves)))));
-    output |= (tempMoves << shift & MACROMASK) & emptySquares;
-
-    shift = 8;
-    MACROMASK = 0xFFFFFFFFFFFFFFFF;
-    fastMask = MACROMASK & enemyStones;
-    tempMoves = (friendlyStones >> shift & fastMask);
-    tempMoves = shiftR(shiftR(shiftR(shiftR(shiftR(tempMoves)))));
-    output |= (tempMoves >> shift & MACROMASK) & emptySquares;
-
-    MACROMASK = 0xFFFFFFFFFFFFFFFF;
-    fastMask = MACROMASK & enemyStones;
-    tempMoves = (friendlyStones << shift & fastMask);
-    tempMoves = shiftL(shiftL(shiftL(shiftL(shiftL(tempMoves)))));
-    output |= (tempMoves << shift & MACROMASK) & emptySquares;
-
-    shift = 7;
-    MACROMASK = 0x00FEFEFEFEFEFEFE;
-    fastMask = MACROMASK & enemyStones;
-    tempMoves = (friendlyStones >> shift & fastMask);
-    tempMoves = shiftR(shiftR(shiftR(shiftR(shiftR(tempMoves)))));
-    output |= (tempMoves >> shift & MACROMASK) & emptySquares;
-
-    MACROMASK = 0x7F7F7F7F7F7F7F00;
-    fastMask = MACROMASK & enemyStones;
-    tempMoves = (friendlyStones << shift & fastMask);
-    tempMoves = shiftL(shiftL(shiftL(shiftL(shiftL(tempMoves)))));
-    output |= (tempMoves << shift & MACROMASK) & emptySquares;
-
-    return output;
-}
-
-// These functions need to be fast.
-// This function is 400 instructions. Ignoring the loop, this should take 100 cycles on an M1 mac
-// Ignoring branches this should take 1/(3.2 * 10 ^ 7) seconds
-__attribute__((always_inline)) void getAllLegalMoves(Position * pos, int8_t ** mlPointer) {
-
-    // Used later in the function
-    bool temp;
-    int8_t * originalPointer = *mlPointer;
-
-    uint64_t output = getAllLegalMovesMask(pos);
-
-    // Worst case is the amount of squares set
-    for(; output; output &= (output-1)) {
-        *(*mlPointer)++ = __builtin_ctzl(output);
-    }
-    // This is a branchless way of setting the first element to -1 if there are no items in the array.
-    temp = (*mlPointer == originalPointer);
-    *(*mlPointer) = temp ? -1 : *(*mlPointer);
-    *(mlPointer) += temp;
-}
-
-// This function is 600 instructions. Ignoring the loop, this should take 150 cycles on an M1 mac
-// Ignoring branches this should take 1.5/(3.2 * 10 ^ 7) seconds
-__attribute__((always_inline)) bool doMove(Position * pos, int8_t square) {
-    // Toggle the turn
-    pos->turn = !pos->turn;
-
-    // If the player is passing
-    if(__builtin_expect(square == -1, 0)) {
-        // Return true if the variable was already true, but also toggle the varible.
-        return !(pos->lastMoveSkipped = !pos->lastMoveSkipped);
-    }
-    // This move was not passed.
-    pos->lastMoveSkipped = false;
-
-    // Keeping in mind that the turn has already been toggled.
-    uint64_t ifCaptured;
-    uint64_t output = 0;
-    const uint64_t friendlyStones = pos->team[!pos->turn];
-    const uint64_t enemyStones = pos->team[pos->turn];
-    // The order of the variables is important.
-    const uint64_t piecePlaced = ONE64 << square;
-
-    // Putting these two lines up here instead of at the bottom adds 4 million Nodes/s
-    pos->team[BLACK] |= ((ONE64 & !pos->turn) << square);
-    pos->team[WHITE] |= ((ONE64 & pos->turn) << square);
-
-    uint64_t fastMask;
-    register uint64_t tempOutput asm("x9");
-
-    register int8_t shift asm("x10");
-    shift = 1;
-    register uint64_t MACROMASK asm("x11");
-    MACROMASK = 0x7F7F7F7F7F7F7F7F;
-    fastMask = MACROMASK & enemyStones;
-    tempOutput = (piecePlaced >> shift & fastMask);
-    tempOutput = shiftR(shiftR(shiftR(shiftR(shiftR(tempOutput)))));
-    ifCaptured = (tempOutput >> shift & MACROMASK) & friendlyStones;
-    output |= (ifCaptured ? tempOutput : 0);
-
-    MACROMASK = 0xFEFEFEFEFEFEFEFE;
-    fastMask = MACROMASK & enemyStones;
-    tempOutput = (piecePlaced << shift & fastMask);
-    tempOutput = shiftL(shiftL(shiftL(shiftL(shiftL(tempOutput)))));
-    ifCaptured = (tempOutput << shift & MACROMASK) & friendlyStones;
-    output |= (ifCaptured ? tempOutput : 0);
-
-    shift = 9;
-    MACROMASK = 0x007F7F7F7F7F7F7F;
-    fastMask = MACROMASK & enemyStones;
-    tempOutput = (piecePlaced >> shift & fastMask);
-    tempOutput = shiftR(shiftR(shiftR(shiftR(shiftR(tempOutput)))));
-    ifCaptured = (tempOutput >> shift & MACROMASK) & friendlyStones;
-    output |= (ifCaptured ? tempOutput : 0);
-
-    MACROMASK = 0xFEFEFEFEFEFEFE00;
-    fastMask = MACROMASK & enemyStones;
-    tempOutput = (piecePlaced << shift & fastMask);
-    tempOutput = shiftL(shiftL(shiftL(shiftL(shiftL(tempOutput)))));
-    ifCaptured = (tempOutput << shift & MACROMASK) & friendlyStones;
-    output |= (ifCaptured ? tempOutput : 0);
-
-    shift = 8;
-    MACROMASK = 0xFFFFFFFFFFFFFFFF;
-    fastMask = MACROMASK & enemyStones;
-    tempOutput = (piecePlaced >> shift & fastMask);
-    tempOutput = shiftR(shiftR(shiftR(shiftR(shiftR(tempOutput)))));
-    ifCaptured = (tempOutput >> shift & MACROMASK) & friendlyStones;
-    output |= (ifCaptured ? tempOutput : 0);
-
-    MACROMASK = 0xFFFFFFFFFFFFFFFF;
-    fastMask = MACROMASK & enemyStones;
-    tempOutput = (piecePlaced << shift & fastMask);
-    tempOutput = shiftL(shiftL(shiftL(shiftL(shiftL(tempOutput)))));
-    ifCaptured = (tempOutput << shift & MACROMASK) & friendlyStones;
-    output |= (ifCaptured ? tempOutput : 0);
-
-    shift = 7;
-    MACROMASK = 0x00FEFEFEFEFEFEFE;
-    fastMask = MACROMASK & enemyStones;
-    tempOutput = (piecePlaced >> shift & fastMask);
-    tempOutput = shiftR(shiftR(shiftR(shiftR(shiftR(tempOutput)))));
-    ifCaptured = (tempOutput >> shift & MACROMASK) & friendlyStones;
-    output |= (ifCaptured ? tempOutput : 0);
-
-    MACROMASK = 0x7F7F7F7F7F7F7F00;
-    fastMask = MACROMASK & enemyStones;
-    tempOutput = (piecePlaced << shift & fastMask);
-    tempOutput = shiftL(shiftL(shiftL(shiftL(shiftL(tempOutput)))));
-    ifCaptured = (tempOutput << shift & MACROMASK) & friendlyStones;
-    output |= (ifCaptured ? tempOutput : 0);
-
-    __builtin_prefetch(&(pos->occupied)); // Adds roughly 2MM Nodes/s
-    pos->team[BLACK] ^= output;
-    pos->team[WHITE] ^= output;
-
-    pos->occupied |= piecePlaced;
-
-    // The game is not over
-    return false;
-}
\ No newline at end of file
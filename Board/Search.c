@@ -0,0 +1,196 @@
+#include <stdio.h>
+#include <math.h>
+#include <limits.h>
+
+#include "Search.h"
+
+// Returned by probCut when no check was confident enough to cut.
+#define MPC_NOCUT 0x7FFFFFFE
+
+uint8_t selectivity = 0;
+
+// How many standard deviations the prediction has to clear the bound by.
+// Roughly 98%, 93% and 84% confidence.
+const float mpcThreshold[MPC_LEVELS] = {0, 2.0, 1.5, 1.0};
+
+CutParams cutParams[MPC_PHASES][MPC_MAXDEPTH + 1][MPC_CHECKS];
+
+int8_t heuristic(Position * pos) {
+	return countBitsSet(pos->team[0]) - countBitsSet(pos->team[1]);
+}
+
+static inline int min(int in, int in2) {
+	return in > in2 ? in2 : in;
+}
+
+static inline int max(int in, int in2) {
+	return in < in2 ? in2 : in;
+}
+
+// End of game scores are from white's side, like the heuristic.
+static inline int terminalScore(Position * pos) {
+	int8_t winner = getWinner(pos);
+	return winner == 1 ? INT_MAX : (winner == -1 ? INT_MIN : 0);
+}
+
+// Splits the 4 to 64 discs of a game into MPC_PHASES equal parts.
+uint8_t getPhase(Position * pos) {
+	return (countBitsSet(pos->occupied) - 4) * MPC_PHASES / 61;
+}
+
+// Returns a negative number if the check doesn't exist at this depth.
+int getShallowDepth(int depth, int check) {
+	return depth - 4 + 2 * check;
+}
+
+// Reads the parameters written by calibrate.
+// Depths that weren't calibrated reuse the parameters from two plies lower,
+// which keeps the parity of the depth pair the same.
+bool loadProbCut(char * path) {
+	FILE * file = fopen(path, "r");
+	if(!file) {
+		return false;
+	}
+
+	char line[256];
+	int phase;
+	int depth;
+	int check;
+	float a;
+	float b;
+	float sigma;
+	while(fgets(line, sizeof(line), file)) {
+		if(line[0] == '#') {
+			continue;
+		}
+		if(sscanf(line, "%d %d %d %f %f %f", &phase, &depth, &check, &a, &b, &sigma) != 6) {
+			continue;
+		}
+		if(phase < 0 || phase >= MPC_PHASES || depth < MPC_MINDEPTH || depth > MPC_MAXDEPTH ||
+		   check < 0 || check >= MPC_CHECKS || getShallowDepth(depth, check) < 0 || a <= 0) {
+			continue;
+		}
+		cutParams[phase][depth][check] = (CutParams) {a, b, sigma, true};
+	}
+	fclose(file);
+
+	for(int p = 0; p < MPC_PHASES; ++p) {
+		for(int d = MPC_MINDEPTH + 2; d <= MPC_MAXDEPTH; ++d) {
+			for(int c = 0; c < MPC_CHECKS; ++c) {
+				if(!cutParams[p][d][c].valid) {
+					cutParams[p][d][c] = cutParams[p][d - 2][c];
+				}
+			}
+		}
+	}
+	return true;
+}
+
+// The first check is searched with a full window so its score can be used
+// twice: it cuts if its prediction clears beta or alpha, and otherwise it
+// decides which of the two tests are worth running the deeper checks for.
+// The deeper checks are null-window and test for both a fail high against
+// beta and a fail low against alpha. Bounds the heuristic can't reach are
+// skipped.
+// Returns the bound the deep search would most likely fail against, or MPC_NOCUT.
+static int probCut(Position * pos, int depth, int alpha, int beta, bool maximizingPlayer) {
+	const float t = mpcThreshold[selectivity];
+	const uint8_t phase = getPhase(pos);
+	bool tryBeta = beta > -MPC_SCOREMAX && beta <= MPC_SCOREMAX;
+	bool tryAlpha = alpha >= -MPC_SCOREMAX && alpha < MPC_SCOREMAX;
+	bool first = true;
+	int bound;
+
+	for(int check = 0; check < MPC_CHECKS && (tryBeta || tryAlpha); ++check) {
+		const int shallow = getShallowDepth(depth, check);
+		const CutParams * params = &cutParams[phase][depth][check];
+		if(shallow < 0 || !params->valid) {
+			continue;
+		}
+		if(first) {
+			first = false;
+			int value = alphaBeta(pos, shallow, INT_MIN, INT_MAX, maximizingPlayer);
+			if(value < -MPC_SCOREMAX || value > MPC_SCOREMAX) {
+				// The game ends within the shallow search, the regression says nothing.
+				return MPC_NOCUT;
+			}
+			const float predicted = params->a * value + params->b;
+			if(tryBeta && predicted - t * params->sigma >= beta) {
+				return beta;
+			}
+			if(tryAlpha && predicted + t * params->sigma <= alpha) {
+				return alpha;
+			}
+			tryBeta = tryBeta && predicted - (t - MPC_GATE) * params->sigma >= beta;
+			tryAlpha = tryAlpha && predicted + (t - MPC_GATE) * params->sigma <= alpha;
+			continue;
+		}
+		if(tryBeta) {
+			// a * v + b - t * sigma >= beta
+			bound = (int) ceilf((beta + t * params->sigma - params->b) / params->a);
+			if(bound <= MPC_SCOREMAX && alphaBeta(pos, shallow, bound - 1, bound, maximizingPlayer) >= bound) {
+				return beta;
+			}
+		}
+		if(tryAlpha) {
+			// a * v + b + t * sigma <= alpha
+			bound = (int) floorf((alpha - t * params->sigma - params->b) / params->a);
+			if(bound >= -MPC_SCOREMAX && alphaBeta(pos, shallow, bound, bound + 1, maximizingPlayer) <= bound) {
+				return alpha;
+			}
+		}
+	}
+	return MPC_NOCUT;
+}
+
+int alphaBeta(Position * pos, int depth, int alpha, int beta, bool maximizingPlayer) {
+    if(depth == 0) {
+        return heuristic(pos);
+    }
+
+    if(selectivity && depth >= MPC_MINDEPTH) {
+        int cut = probCut(pos, depth, alpha, beta, maximizingPlayer);
+        if(cut != MPC_NOCUT) {
+            return cut;
+        }
+    }
+
+    int8_t moveList[MAXPOSSIBLEMOVES];
+    int8_t * last = moveList;
+
+    getAllLegalMoves(pos, &last);
+
+    int value;
+    Position undoMove = *pos;
+    if(maximizingPlayer) {
+        value = INT_MIN;
+        for(int i = 0; __builtin_expect(i < (last - moveList), 1); ++i) {
+            if(doMove(pos, moveList[i])) {
+	            *pos = undoMove;
+	            return terminalScore(pos);
+	        }
+            value = max(value, alphaBeta(pos, depth - 1, alpha, beta, !maximizingPlayer));
+            *pos = undoMove;
+            if (value >= beta) {
+                break; // beta cutoff
+            }
+            alpha = max(alpha, value);
+        }
+        return value;
+    } else {
+        value = INT_MAX;
+        for(int i = 0; __builtin_expect(i < (last - moveList), 1); ++i) {
+        	if(doMove(pos, moveList[i])) {
+	            *pos = undoMove;
+	            return terminalScore(pos);
+	        }
+            value = min(value, alphaBeta(pos, depth - 1, alpha, beta, !maximizingPlayer));
+            *pos = undoMove;
+            if (value <= alpha) {
+                break; // alpha cutoff
+            }
+            beta = min(beta, value);
+    	}
+        return value;
+    }
+}
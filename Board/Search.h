@@ -0,0 +1,51 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Board.h"
+
+static const uint8_t MAXPOSSIBLEMOVES = 32;
+
+// Multi-ProbCut
+/* Before searching a node to depth d, a few shallower searches are run. The
+deep score is modelled as v_d = a * v_shallow + b with a normally
+distributed error of standard deviation sigma. If the shallow score says the
+deep search fails high (or low) with enough confidence, the node is cut.
+
+The parameters are fitted per game phase, deep depth and check by the
+calibrate program and loaded from a text file with one entry per line:
+phase depth check a b sigma
+*/
+#define MPC_PHASES 6
+#define MPC_MAXDEPTH 60
+#define MPC_MINDEPTH 3
+// Check i at depth d uses a shallow search of depth d - 4 + 2 * i.
+#define MPC_CHECKS 2
+// The deeper checks only run if the first one cleared the bound at
+// MPC_GATE fewer standard deviations than the cut itself needs.
+#define MPC_GATE 1.0
+// Selectivity 0 is a full-width search, higher levels prune more.
+#define MPC_LEVELS 4
+// The heuristic can never leave this range, terminal scores do.
+#define MPC_SCOREMAX 64
+
+typedef struct {
+    float a;
+    float b;
+    float sigma;
+    bool valid;
+} CutParams;
+
+extern uint8_t selectivity;
+extern const float mpcThreshold[MPC_LEVELS];
+extern CutParams cutParams[MPC_PHASES][MPC_MAXDEPTH + 1][MPC_CHECKS];
+
+int8_t heuristic(Position * pos);
+uint8_t getPhase(Position * pos);
+int getShallowDepth(int depth, int check);
+bool loadProbCut(char * path);
+int alphaBeta(Position * pos, int depth, int alpha, int beta, bool maximizingPlayer);
+
+#endif
@@ -0,0 +1,196 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <limits.h>
+
+#include "Board.h"
+#include "Search.h"
+
+// Fits the Multi-ProbCut parameters used by alphaBeta.
+/* Positions are sampled by playing random moves from the starting position.
+Each one is searched full-width at every depth up to maxDepth, and the
+deep score is regressed against the shallow score for every depth pair
+of every phase: v_deep = a * v_shallow + b, sigma being the standard
+deviation of the residuals. Positions where a search reached the end of
+the game are skipped since their scores aren't on the heuristic's scale.
+*/
+
+const int32_t SAMPLESDEFAULT = 100;
+int32_t samples = SAMPLESDEFAULT;
+
+const int32_t MAXDEPTHDEFAULT = 10;
+const int32_t MAXDEPTHMIN = MPC_MINDEPTH;
+const int32_t MAXDEPTHMAX = 14;
+int32_t maxDepth = MAXDEPTHDEFAULT;
+
+unsigned int seed = 1;
+
+char * outFile = "probcut.txt";
+
+// Fewer samples than this and the fit is thrown away.
+const int32_t MINSAMPLES = 10;
+
+typedef struct {
+    double n;
+    double x;
+    double y;
+    double xx;
+    double xy;
+    double yy;
+} Sums;
+
+Sums sums[MPC_PHASES][MPC_MAXDEPTH + 1][MPC_CHECKS];
+
+void printUsage(char **argv) {
+    printf("Usage: %s [-samples #] [-maxdepth #] [-seed #] [-out <file>]\n", argv[0]);
+    printf("\n\t-samples - Positions to sample per phase, default %d.\n", SAMPLESDEFAULT);
+    printf("\n\t-maxdepth - Deepest search to calibrate, default %d.\n", MAXDEPTHDEFAULT);
+    printf("\n\t-seed - Seed for the random positions, default %u.\n", seed);
+    printf("\n\t-out - File to write the parameters to, default %s.\n", outFile);
+}
+
+void handleArgs(int argc, char ** argv) {
+    for(int i = 1; i < argc; ++i) {
+        // Arguments with parameters
+        if(strcmp("-samples", argv[i]) == 0 && (i < (argc-1))) {
+            ++i;
+            samples = atoi(argv[i]);
+            if(samples < MINSAMPLES) {
+                printf("Samples should be at least %d.\n", MINSAMPLES);
+                exit(1);
+            }
+        }
+        else if(strcmp("-maxdepth", argv[i]) == 0 && (i < (argc-1))) {
+            ++i;
+            maxDepth = atoi(argv[i]);
+            if(maxDepth < MAXDEPTHMIN || maxDepth > MAXDEPTHMAX) {
+                printf("Max depth was out of bounds, it should be between %d and %d.\n", MAXDEPTHMIN, MAXDEPTHMAX);
+                exit(1);
+            }
+        }
+        else if(strcmp("-seed", argv[i]) == 0 && (i < (argc-1))) {
+            ++i;
+            seed = (unsigned int) atoi(argv[i]);
+        }
+        else if(strcmp("-out", argv[i]) == 0 && (i < (argc-1))) {
+            ++i;
+            outFile = argv[i];
+        }
+        // Arguments with no parameters
+        else if(strcmp("-help", argv[i]) == 0) {
+            printUsage(argv);
+            exit(0);
+        }
+        else {
+            printf("Unknown argument: %s\n", argv[i]);
+            printUsage(argv);
+            exit(1);
+        }
+    }
+}
+
+// Plays random moves until the position reaches the wanted phase.
+// Returns false if the game ended first.
+bool samplePosition(Position * pos, uint8_t phase) {
+    int8_t moveList[MAXPOSSIBLEMOVES];
+    int8_t * last;
+
+    *pos = createBoard("8/8/8/3WB3/3BW3/8/8/8 1 0");
+    // Somewhere random inside the phase, not always its first position.
+    int32_t extra = rand() % 8;
+    while(getPhase(pos) < phase || (getPhase(pos) == phase && extra-- > 0)) {
+        last = moveList;
+        getAllLegalMoves(pos, &last);
+        if(doMove(pos, moveList[rand() % (last - moveList)])) {
+            return false;
+        }
+    }
+    return getPhase(pos) == phase;
+}
+
+void addSample(Position * pos, uint8_t phase) {
+    int values[MAXDEPTHMAX + 1];
+    Position copy;
+    for(int d = 0; d <= maxDepth; ++d) {
+        copy = *pos;
+        values[d] = alphaBeta(&copy, d, INT_MIN, INT_MAX, pos->turn == WHITE);
+        if(values[d] < -MPC_SCOREMAX || values[d] > MPC_SCOREMAX) {
+            // Only the depths that stayed on the heuristic's scale are usable.
+            break;
+        }
+        for(int c = 0; c < MPC_CHECKS; ++c) {
+            int shallow = getShallowDepth(d, c);
+            if(d < MPC_MINDEPTH || shallow < 0) {
+                continue;
+            }
+            double x = values[shallow];
+            double y = values[d];
+            Sums * s = &sums[phase][d][c];
+            s->n += 1;
+            s->x += x;
+            s->y += y;
+            s->xx += x * x;
+            s->xy += x * y;
+            s->yy += y * y;
+        }
+    }
+}
+
+void writeParams(FILE * file) {
+    fprintf(file, "# Multi-ProbCut parameters written by calibrate.\n");
+    fprintf(file, "# %d samples per phase, max depth %d, seed %u.\n", samples, maxDepth, seed);
+    fprintf(file, "# phase depth check a b sigma\n");
+    for(int p = 0; p < MPC_PHASES; ++p) {
+        for(int d = MPC_MINDEPTH; d <= maxDepth; ++d) {
+            for(int c = 0; c < MPC_CHECKS; ++c) {
+                Sums * s = &sums[p][d][c];
+                if(s->n < MINSAMPLES) {
+                    continue;
+                }
+                double varX = s->xx - s->x * s->x / s->n;
+                double covXY = s->xy - s->x * s->y / s->n;
+                if(varX <= 0) {
+                    continue;
+                }
+                double a = covXY / varX;
+                double b = (s->y - a * s->x) / s->n;
+                // Sum of squared residuals of the least squares line.
+                double residuals = s->yy - s->y * s->y / s->n - a * covXY;
+                double sigma = sqrt(fmax(residuals, 0) / s->n);
+                if(a <= 0) {
+                    continue;
+                }
+                fprintf(file, "%d %d %d %.4f %.4f %.4f\n", p, d, c, a, b, sigma);
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    handleArgs(argc, argv);
+    // The calibration searches have to be full-width.
+    selectivity = 0;
+    srand(seed);
+
+    Position pos;
+    clock_t timeBegin = clock();
+    for(uint8_t p = 0; p < MPC_PHASES; ++p) {
+        for(int i = 0; i < samples; ++i) {
+            while(!samplePosition(&pos, p)) {}
+            addSample(&pos, p);
+        }
+        double timeTaken = ((double) (clock() - timeBegin)) / CLOCKS_PER_SEC;
+        printf("Phase %d sampled, %.1lf seconds so far.\n", p, timeTaken);
+    }
+
+    FILE * file = fopen(outFile, "w");
+    if(!file) {
+        printf("Couldn't open %s for writing.\n", outFile);
+        return 1;
+    }
+    writeParams(file);
+    fclose(file);
+    printf("Wrote %s.\n", outFile);
+}
@@ -4,7 +4,7 @@
 #include <time.h>
 #include <string.h>
 
-#include "Board.c"
+#include "Board.h"
 
 const int32_t DEPTHDEFAULT = 12;
 const int32_t DEPTHMIN = 1;
@@ -1,13 +1,63 @@
+#include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
 #include "Board.h"
+#include "Search.h"
+
+const int32_t DEPTHDEFAULT = 12;
+const int32_t DEPTHMIN = 1;
+const int32_t DEPTHMAX = 60;
+int32_t depth = DEPTHDEFAULT;
 
-#define INT_MAX  2147483647
-#define INT_MIN -2147483648
+const uint8_t SELECTIVITYDEFAULT = 0;
 
-const uint8_t MAXPOSSIBLEMOVES = 32;
+char * probCutFile = "probcut.txt";
 
-int8_t heuristic(Position * pos) {
-	return countBitsSet(pos->team[0]) - countBitsSet(pos->team[1]);
+void printUsage(char **argv) {
+    printf("Usage: %s [-depth #] [-selectivity #] [-probcut <file>]\n", argv[0]);
+    printf("\n\t-depth - Select a depth for the computer to search to, default %d.\n", DEPTHDEFAULT);
+    printf("\n\t-selectivity - Multi-ProbCut level from 0 (full-width) to %d (most pruning), default %d.\n", MPC_LEVELS - 1, SELECTIVITYDEFAULT);
+    printf("\n\t-probcut - File written by calibrate, default %s.\n", probCutFile);
+}
+
+void handleArgs(int argc, char ** argv) {
+    selectivity = SELECTIVITYDEFAULT;
+    for(int i = 1; i < argc; ++i) {
+        // Arguments with parameters
+        if(strcmp("-depth", argv[i]) == 0 && (i < (argc-1))) {
+            ++i;
+            depth = atoi(argv[i]);
+            if(depth < DEPTHMIN || depth > DEPTHMAX) {
+                printf("Depth was out of bounds, depth should be between %d and %d.\n", DEPTHMIN, DEPTHMAX);
+                exit(1);
+            }
+        }
+        else if(strcmp("-selectivity", argv[i]) == 0 && (i < (argc-1))) {
+            ++i;
+            int level = atoi(argv[i]);
+            if(level < 0 || level >= MPC_LEVELS) {
+                printf("Selectivity was out of bounds, selectivity should be between 0 and %d.\n", MPC_LEVELS - 1);
+                exit(1);
+            }
+            selectivity = level;
+        }
+        else if(strcmp("-probcut", argv[i]) == 0 && (i < (argc-1))) {
+            ++i;
+            probCutFile = argv[i];
+        }
+        // Arguments with no parameters
+        else if(strcmp("-help", argv[i]) == 0) {
+            printUsage(argv);
+            exit(0);
+        }
+        else {
+            printf("Unknown argument: %s\n", argv[i]);
+            printUsage(argv);
+            exit(1);
+        }
+    }
 }
 
 int8_t getPlayerMove(Position * pos) {
@@ -35,61 +85,6 @@ int8_t getPlayerMove(Position * pos) {
 	} while(1);
 }
 
-int min(int in, int in2) {
-	return in > in2 ? in2 : in;
-}
-
-int max(int in, int in2) {
-	return in < in2 ? in2 : in;
-}
-
-int alphaBeta(Position * pos, int depth, int alpha, int beta, bool maximizingPlayer) {
-    if(depth == 0) {
-        return heuristic(pos);
-    }
-
-    int8_t moveList[MAXPOSSIBLEMOVES];
-    int8_t * last = moveList;
-
-    getAllLegalMoves(pos, &last);
-
-    int value;
-    Position undoMove = *pos;
-    if(maximizingPlayer) {
-        value = INT_MIN;
-        for(int i = 0; __builtin_expect(i < (last - moveList), 1); ++i) {
-            if(doMove(pos, moveList[i])) {
-	            *pos = undoMove;
-	            value = getWinner(pos) == maximizingPlayer ? INT_MAX : INT_MIN;
-	            return value;
-	        }
-            value = max(value, alphaBeta(pos, depth - 1, alpha, beta, !maximizingPlayer));
-            *pos = undoMove;
-            if (value >= beta) {
-                break; // beta cutoff
-            }
-            alpha = max(alpha, value);
-        }
-        return value;
-    } else {
-        value = INT_MAX;
-        for(int i = 0; __builtin_expect(i < (last - moveList), 1); ++i) {
-        	if(doMove(pos, moveList[i])) {
-	            *pos = undoMove;
-	            value = getWinner(pos) == maximizingPlayer ? INT_MAX : INT_MIN;
-	            return value;
-	        }
-            value = min(value, alphaBeta(pos, depth - 1, alpha, beta, !maximizingPlayer));
-            *pos = undoMove;
-            if (value <= alpha) {
-                break; // alpha cutoff
-            }
-            beta = min(beta, value);
-    	}
-        return value;
-    }
-}
-
 int8_t getComputerMove(Position * pos, int depth, bool maximizingPlayer) {
 	int8_t moveList[MAXPOSSIBLEMOVES];
     int8_t * last = moveList;
@@ -110,7 +105,8 @@ int8_t getComputerMove(Position * pos, int depth, bool maximizingPlayer) {
             }
 
         }
-        tempVal = alphaBeta(pos, depth, INT_MIN, INT_MAX, !maximizingPlayer);
+        // Searching the rest with value as alpha lets the replies cut (and ProbCut) against it.
+        tempVal = alphaBeta(pos, depth, value, INT_MAX, !maximizingPlayer);
       	if(tempVal > value) {
       		value = tempVal;
       		bestMove = moveList[i];
@@ -120,7 +116,13 @@ int8_t getComputerMove(Position * pos, int depth, bool maximizingPlayer) {
     return bestMove;
 }
 
-int main() {
+int main(int argc, char **argv) {
+	handleArgs(argc, argv);
+	if(selectivity && !loadProbCut(probCutFile)) {
+		printf("Couldn't read %s, searching full-width.\n", probCutFile);
+		selectivity = 0;
+	}
+
 	Position pos = createBoard("8/8/8/3WB3/3BW3/8/8/8 1 0");
 	Position * posPtr = &pos;
 	int8_t move;
@@ -130,7 +132,8 @@ int main() {
 		if(pos.turn & playerMove) {
 			move = getPlayerMove(posPtr);
 		} else {
-			move = getComputerMove(posPtr, 12, pos.turn);
+			// The heuristic is white minus black, so white is the maximizing player.
+			move = getComputerMove(posPtr, depth, pos.turn == WHITE);
 		}
 	} while(!doMove(posPtr, move));
 